@@ -0,0 +1,250 @@
+#include <simple_svg.hpp>
+#include "../example/scene.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <map>
+
+using namespace svg;
+
+// Output and throughput regression check for the serializer.
+//
+// Renders the scene of example/main.cpp repeated 1x, 10x, ... up to
+// --max-scale times and compares every output against the golden hash,
+// size and throughput stored in the baseline file.
+//
+//   simple-svg-regression [--baseline file] [--threshold 0.5]
+//                         [--max-scale 100000] [--allow-changes]
+//                         [--check-throughput] [--update]
+//
+// --threshold         allowed relative loss in elements/sec and growth in bytes
+// --allow-changes     accept different output as long as its size is in bounds
+// --check-throughput  also compare elements/sec against the baseline
+// --update            write the measured values as the new baseline
+//
+// Throughput depends on the machine, so it is only compared when asked for;
+// regenerate the baseline with --update on that machine first.
+
+#ifndef SIMPLE_SVG_BASELINE
+#define SIMPLE_SVG_BASELINE "baseline.txt"
+#endif
+
+struct Measurement
+{
+    std::size_t bytes = 0;
+    std::uint64_t hash = 0;
+    double elements_per_second = 0;
+};
+
+std::uint64_t fnv1a(std::string const & data)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::size_t countElements(std::string const & data)
+{
+    std::size_t count = 0;
+    for (std::size_t pos = data.find("\n\t<"); pos != std::string::npos; pos = data.find("\n\t<", pos + 1))
+        ++count;
+    return count;
+}
+
+// Keeps copies of the scene shapes so they can be handed to renderBatch.
+struct ShapeCollector
+{
+    template <typename T>
+    ShapeCollector & operator<<(T const & shape)
+    {
+        shapes.push_back(std::make_shared<T const>(shape));
+        return *this;
+    }
+    std::vector<std::shared_ptr<Shape const>> shapes;
+};
+
+std::string readFile(std::string const & file_name)
+{
+    std::ifstream in(file_name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// renderBatch assembles documents on its own, so check it against Document.
+// Several jobs on several threads, one of them with a destination that
+// cannot be written.
+bool batchMatchesDocument()
+{
+    Dimensions dimensions(100, 100);
+    Layout::Origin const origins[] = { Layout::Origin::TopLeft, Layout::Origin::BottomLeft,
+                                       Layout::Origin::TopRight, Layout::Origin::BottomRight };
+
+    ShapeCollector scene;
+    exampleScene(scene, dimensions);
+
+    std::vector<BatchJob> jobs;
+    std::vector<std::string> expected;
+    for (unsigned i = 0; i < 64; ++i) {
+        Layout layout(dimensions, Dimensions(900, 900), origins[i % 4], 1 + i % 3);
+        std::ostringstream sink;
+        Document doc(sink, layout);
+        jobs.emplace_back(layout, "serializer-regression-batch-" + std::to_string(i) + ".svg");
+        for (auto const & shape : scene.shapes) {
+            doc << *shape;
+            jobs.back() << *shape;
+        }
+        expected.push_back(doc.toString());
+    }
+    jobs.emplace_back(Layout(dimensions), "serializer-regression-missing/batch.svg");
+
+    bool ok = renderBatch(jobs, 4) == jobs.size() - 1;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ok = readFile(jobs[i].file_name) == expected[i] && ok;
+        std::remove(jobs[i].file_name.c_str());
+    }
+    return ok;
+}
+
+Measurement measure(std::size_t scale)
+{
+    using clock = std::chrono::steady_clock;
+
+    Dimensions dimensions(100, 100);
+    Dimensions window(900, 900);
+
+    // Repeat small scenes so the timing is not dominated by clock resolution.
+    Measurement result;
+    std::chrono::duration<double> total(0);
+    double best = 0;
+    do {
+        std::ostringstream sink;
+        auto start = clock::now();
+        Document doc(sink, Layout(dimensions, window, Layout::Origin::BottomLeft));
+        for (std::size_t i = 0; i < scale; ++i)
+            exampleScene(doc, dimensions);
+        std::string output = doc.toString();
+        std::chrono::duration<double> elapsed = clock::now() - start;
+
+        total += elapsed;
+        best = best == 0 ? elapsed.count() : std::min(best, elapsed.count());
+        if (result.bytes == 0) {
+            result.bytes = output.size();
+            result.hash = fnv1a(output);
+            result.elements_per_second = static_cast<double>(countElements(output));
+        }
+    } while (total.count() < 0.2);
+
+    result.elements_per_second /= best;
+    return result;
+}
+
+std::map<std::size_t, Measurement> readBaseline(std::string const & file_name)
+{
+    std::map<std::size_t, Measurement> baseline;
+    std::ifstream in(file_name);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        std::size_t scale;
+        Measurement m;
+        if (fields >> scale >> m.bytes >> std::hex >> m.hash >> std::dec >> m.elements_per_second)
+            baseline[scale] = m;
+    }
+    return baseline;
+}
+
+bool writeBaseline(std::string const & file_name, std::map<std::size_t, Measurement> const & results)
+{
+    std::ofstream out(file_name);
+    out << "# scale bytes fnv1a64 elements_per_second\n";
+    for (auto const & [scale, m] : results)
+        out << scale << ' ' << m.bytes << ' ' << std::hex << m.hash << std::dec
+            << ' ' << static_cast<std::uint64_t>(m.elements_per_second) << '\n';
+    return out.good();
+}
+
+int main(int argc, char ** argv)
+{
+    std::string baseline_file = SIMPLE_SVG_BASELINE;
+    double threshold = 0.5;
+    std::size_t max_scale = 100000;
+    bool allow_changes = false;
+    bool check_throughput = false;
+    bool update = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--baseline" && i + 1 < argc)
+            baseline_file = argv[++i];
+        else if (arg == "--threshold" && i + 1 < argc)
+            threshold = std::atof(argv[++i]);
+        else if (arg == "--max-scale" && i + 1 < argc)
+            max_scale = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--allow-changes")
+            allow_changes = true;
+        else if (arg == "--check-throughput")
+            check_throughput = true;
+        else if (arg == "--update")
+            update = true;
+        else {
+            std::cerr << "unknown argument: " << arg << "\n";
+            return 2;
+        }
+    }
+
+    std::map<std::size_t, Measurement> baseline = readBaseline(baseline_file);
+    std::map<std::size_t, Measurement> results;
+    bool failed = false;
+
+    if (!batchMatchesDocument()) {
+        std::cout << "renderBatch output differs from Document\n";
+        failed = true;
+    }
+
+    for (std::size_t scale = 1; scale <= max_scale; scale *= 10) {
+        Measurement m = measure(scale);
+        results[scale] = m;
+
+        std::cout << "scale " << scale << ": " << m.bytes << " bytes, "
+                  << static_cast<std::uint64_t>(m.elements_per_second) << " elements/s";
+
+        auto expected = baseline.find(scale);
+        if (update || expected == baseline.end()) {
+            std::cout << (update ? "\n" : " (no baseline)\n");
+            continue;
+        }
+
+        Measurement const & b = expected->second;
+        if (m.hash != b.hash) {
+            std::cout << " [output changed: " << b.bytes << " -> " << m.bytes << " bytes]";
+            failed |= !allow_changes;
+        }
+        if (m.bytes > b.bytes * (1 + threshold)) {
+            std::cout << " [output size regressed]";
+            failed = true;
+        }
+        if (check_throughput && m.elements_per_second < b.elements_per_second * (1 - threshold)) {
+            std::cout << " [throughput regressed from "
+                      << static_cast<std::uint64_t>(b.elements_per_second) << "]";
+            failed = true;
+        }
+        std::cout << "\n";
+    }
+
+    if (update) {
+        if (!writeBaseline(baseline_file, results)) {
+            std::cerr << "could not write " << baseline_file << "\n";
+            return 1;
+        }
+        std::cout << "baseline written to " << baseline_file << "\n";
+    }
+
+    return failed ? 1 : 0;
+}
@@ -42,6 +42,25 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <optional>
 #include <string>
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <iterator>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SIMPLE_SVG_MAPPED_FILE
+#define SIMPLE_SVG_POSIX_IO
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace svg
 {
     // Utility XML/String Functions.
@@ -53,6 +72,29 @@ namespace svg
         ss << attribute_name << "=\"" << value << unit << "\" ";
         return ss.str();
     }
+    // Appends a number with six significant digits like the default std::ostream
+    // output (or like std::to_string with chars_format::fixed), independent
+    // of the C locale.
+    void appendNumber(std::string & out, double value,
+        std::chars_format format = std::chars_format::general)
+    {
+        char buffer[512];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value, format, 6);
+        out.append(buffer, result.ptr);
+    }
+    // Overloads for the common value types that skip the stringstream.
+    std::string attribute(std::string const & attribute_name,
+        double value, std::string const & unit = "")
+    {
+        std::string out = attribute_name + "=\"";
+        appendNumber(out, value);
+        return out + unit + "\" ";
+    }
+    std::string attribute(std::string const & attribute_name,
+        std::string const & value, std::string const & unit = "")
+    {
+        return attribute_name + "=\"" + value + unit + "\" ";
+    }
     std::string elemStart(std::string const & element_name)
     {
         return "\t<" + element_name + " ";
@@ -132,6 +174,13 @@ namespace svg
         double scale;
         Origin origin;
         Point origin_offset;
+    private:
+        friend class Group;
+        friend class Text;
+        // Signs of the axes of the transform applied by enclosing groups,
+        // so that Text can turn its glyphs back upright.
+        double group_sign_x = 1;
+        double group_sign_y = 1;
     };
 
     // Convert coordinates in user space to SVG native space.
@@ -169,6 +218,48 @@ namespace svg
         return dimension * layout.scale;
     }
 
+    // Affine transform in SVG matrix(a b c d e f) notation:
+    // x' = a * x + c * y + e, y' = b * x + d * y + f
+    struct Transform
+    {
+        explicit Transform(double a_ = 1, double b_ = 0, double c_ = 0,
+                  double d_ = 1, double e_ = 0, double f_ = 0)
+            : a(a_), b(b_), c(c_), d(d_), e(e_), f(f_) { }
+        static Transform translate(Point const & offset)
+        {
+            return Transform(1, 0, 0, 1, offset.x, offset.y);
+        }
+        static Transform scale(double factor)
+        {
+            return Transform(factor, 0, 0, factor, 0, 0);
+        }
+        // Result applies rhs first, then *this.
+        Transform operator*(Transform const & rhs) const
+        {
+            return Transform(a * rhs.a + c * rhs.b, b * rhs.a + d * rhs.b,
+                             a * rhs.c + c * rhs.d, b * rhs.c + d * rhs.d,
+                             a * rhs.e + c * rhs.f + e, b * rhs.e + d * rhs.f + f);
+        }
+        double a, b, c, d, e, f;
+    };
+
+    // The transform translateX/translateY apply to every point, as a matrix.
+    Transform layoutTransform(Layout const & layout)
+    {
+        double scale = layout.scale;
+        Transform transform(scale, 0, 0, scale,
+                            layout.origin_offset.x * scale, layout.origin_offset.y * scale);
+        if (layout.origin == Layout::Origin::TopRight || layout.origin == Layout::Origin::BottomRight) {
+            transform.a = -transform.a;
+            transform.e = layout.dimensions.width - transform.e;
+        }
+        if (layout.origin == Layout::Origin::BottomLeft || layout.origin == Layout::Origin::BottomRight) {
+            transform.d = -transform.d;
+            transform.f = layout.dimensions.height - transform.f;
+        }
+        return transform;
+    }
+
     class Serializeable
     {
     public:
@@ -498,9 +589,22 @@ namespace svg
         std::string toString(Layout const & layout) const
         {
             std::stringstream ss;
-            ss << elemStart("text") << attribute("x", translateX(layout, origin.x))
-                << attribute("y", translateY(layout, origin.y))
-                << fill.toString(layout) << stroke.toString(layout) << font.toString(layout)
+            ss << elemStart("text");
+            if (layout.group_sign_x < 0 || layout.group_sign_y < 0) {
+                std::string flip = "matrix(";
+                appendNumber(flip, layout.group_sign_x);
+                flip += " 0 0 ";
+                appendNumber(flip, layout.group_sign_y);
+                flip += ' ';
+                appendNumber(flip, translateX(layout, origin.x));
+                flip += ' ';
+                appendNumber(flip, translateY(layout, origin.y));
+                ss << attribute("x", 0.0) << attribute("y", 0.0) << attribute("transform", flip + ")");
+            } else {
+                ss << attribute("x", translateX(layout, origin.x))
+                   << attribute("y", translateY(layout, origin.y));
+            }
+            ss << fill.toString(layout) << stroke.toString(layout) << font.toString(layout)
                 << ">" << content << elemEnd("text");
             return ss.str();
         }
@@ -515,6 +619,64 @@ namespace svg
         Font font;
     };
 
+    // Container whose children are written in raw user coordinates. The layout
+    // and the group transform are emitted once as the transform of a <g>
+    // element, so offset() and transform() are O(1) regardless of the number
+    // of children. Text inside a group that mirrors an axis is flipped back
+    // upright; this assumes the transforms are not rotated or sheared.
+    class Group : public Shape
+    {
+    public:
+        explicit Group(Transform const & matrix_ = Transform()) : matrix(matrix_) { }
+        // Stores a copy of the shape made through its static type T. Shapes
+        // only known through a base class are added as shared pointers.
+        template <typename T, typename = std::enable_if_t<std::is_base_of_v<Shape, T>>>
+        Group & operator<<(T const & shape)
+        {
+            children.push_back(std::make_shared<T const>(shape));
+            return *this;
+        }
+        template <typename T, typename = std::enable_if_t<std::is_base_of_v<Shape, T>>>
+        Group & operator<<(std::shared_ptr<T> const & shape)
+        {
+            if (shape)
+                children.push_back(shape);
+            return *this;
+        }
+        std::string toString(Layout const & layout) const
+        {
+            Transform combined = layoutTransform(layout) * matrix;
+            Layout identity(layout.dimensions, layout.window, Layout::Origin::TopLeft);
+            identity.group_sign_x = combined.a < 0 ? -layout.group_sign_x : layout.group_sign_x;
+            identity.group_sign_y = combined.d < 0 ? -layout.group_sign_y : layout.group_sign_y;
+
+            std::string ret = elemStart("g") + "transform=\"matrix(";
+            for (double value : { combined.a, combined.b, combined.c, combined.d, combined.e }) {
+                appendNumber(ret, value);
+                ret += ' ';
+            }
+            appendNumber(ret, combined.f);
+            ret += ")\" >\n";
+
+            for (unsigned i = 0; i < children.size(); ++i)
+                ret += children[i]->toString(identity);
+
+            return ret + elemEnd("g");
+        }
+        void offset(Point const & offset)
+        {
+            matrix = Transform::translate(offset) * matrix;
+        }
+        // Applies transform_ after the current group transform.
+        void transform(Transform const & transform_)
+        {
+            matrix = transform_ * matrix;
+        }
+    private:
+        Transform matrix;
+        std::vector<std::shared_ptr<Shape const>> children;
+    };
+
     // Sample charting class.
     class LineChart : public Shape
     {
@@ -602,49 +764,300 @@ namespace svg
         }
     };
 
+    // The XML prolog and DOCTYPE are identical for every document.
+    constexpr char const svgProlog[] =
+        "<?xml version=\"1.0\" standalone=\"no\" ?>\n"
+        "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
+        "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n";
+
+    // Appends the prolog and the opening svg element for the given layout.
+    void appendHeader(std::string & out, Layout const & layout)
+    {
+        out += svgProlog;
+        out += "<svg width=\"";
+        appendNumber(out, layout.window.width);
+        out += "px\" height=\"";
+        appendNumber(out, layout.window.height);
+        out += "px\" viewBox=\"0 0 ";
+        appendNumber(out, layout.dimensions.width, std::chars_format::fixed);
+        out += ' ';
+        appendNumber(out, layout.dimensions.height, std::chars_format::fixed);
+        out += "\" preserveAspectRatio=\"xMinYMin meet\" "
+               "xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\" >\n";
+    }
+
+#ifdef SIMPLE_SVG_MAPPED_FILE
+    // File sink that writes through a shared memory mapping. Space is really
+    // preallocated on disk before it is mapped, so running out of space makes
+    // append() fail instead of faulting. The mapping starts at min_step bytes
+    // and doubles, by at most max_step at a time; finish() truncates the file
+    // to the number of bytes actually written. Only regular files are mapped,
+    // good() is false for anything else.
+    class MappedFile
+    {
+    public:
+        static constexpr std::size_t min_step = 1 << 20;
+        static constexpr std::size_t max_step = 64 << 20;
+
+        explicit MappedFile(std::string const & file_name)
+        {
+            // Check before opening: opening a FIFO, even briefly, is visible
+            // to its reader.
+            struct stat info;
+            if (::stat(file_name.c_str(), &info) == 0 && !S_ISREG(info.st_mode))
+                return;
+
+            fd = ::open(file_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+            if (fd < 0)
+                return;
+
+            if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)
+                || ::ftruncate(fd, 0) != 0 || !reserve(min_step)) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        MappedFile(MappedFile const &) = delete;
+        MappedFile & operator=(MappedFile const &) = delete;
+        MappedFile(MappedFile && other)
+            : fd(other.fd), failed(other.failed), data(other.data)
+            , size(other.size), capacity(other.capacity)
+        {
+            other.release();
+        }
+        MappedFile & operator=(MappedFile && other)
+        {
+            if (this != &other) {
+                finish();
+                fd = other.fd;
+                failed = other.failed;
+                data = other.data;
+                size = other.size;
+                capacity = other.capacity;
+                other.release();
+            }
+            return *this;
+        }
+        ~MappedFile()
+        {
+            finish();
+        }
+
+        bool good() const
+        {
+            return fd >= 0 && !failed;
+        }
+        bool isOpen() const
+        {
+            return fd >= 0;
+        }
+        // Bytes written so far; valid until the next append or finish().
+        std::string_view contents() const
+        {
+            return data ? std::string_view(data, size) : std::string_view();
+        }
+        // Grows file and mapping to hold at least new_capacity bytes.
+        bool reserve(std::size_t new_capacity)
+        {
+            if (!good())
+                return false;
+            if (new_capacity <= capacity)
+                return true;
+
+            if (!preallocate(new_capacity)) {
+                failed = true;
+                return false;
+            }
+
+            if (data)
+                ::munmap(data, capacity);
+            void * mapping = ::mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                data = nullptr;
+                capacity = 0;
+                failed = true;
+                return false;
+            }
+            data = static_cast<char *>(mapping);
+            capacity = new_capacity;
+            return true;
+        }
+        bool append(char const * bytes, std::size_t length)
+        {
+            if (!good())
+                return false;
+            if (size + length > capacity) {
+                std::size_t step = std::min(std::max(capacity, min_step), max_step);
+                if (!reserve(std::max(size + length, capacity + step)))
+                    return false;
+            }
+            std::copy(bytes, bytes + length, data + size);
+            size += length;
+            return true;
+        }
+        bool append(std::string const & bytes)
+        {
+            return append(bytes.data(), bytes.size());
+        }
+        // Unmaps, truncates the file to its exact length and closes it.
+        bool finish()
+        {
+            if (fd < 0)
+                return false;
+
+            if (data)
+                ::munmap(data, capacity);
+            bool ok = ::ftruncate(fd, static_cast<off_t>(size)) == 0 && !failed;
+            ok = ::close(fd) == 0 && ok;
+
+            release();
+            return ok;
+        }
+        // Empties and closes the file, dropping everything appended so far.
+        void discard()
+        {
+            if (fd < 0)
+                return;
+
+            size = 0;
+            finish();
+        }
+    private:
+        int fd = -1;
+        bool failed = false;
+        char * data = nullptr;
+        std::size_t size = 0;
+        std::size_t capacity = 0;
+
+        void release()
+        {
+            fd = -1;
+            failed = false;
+            data = nullptr;
+            size = 0;
+            capacity = 0;
+        }
+        bool preallocate(std::size_t new_capacity)
+        {
+#if defined(__APPLE__)
+            fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0,
+                               static_cast<off_t>(new_capacity - capacity), 0 };
+            if (::fcntl(fd, F_PREALLOCATE, &store) == -1) {
+                store.fst_flags = F_ALLOCATEALL;
+                if (::fcntl(fd, F_PREALLOCATE, &store) == -1)
+                    return false;
+            }
+            return ::ftruncate(fd, static_cast<off_t>(new_capacity)) == 0;
+#else
+            return ::posix_fallocate(fd, 0, static_cast<off_t>(new_capacity)) == 0;
+#endif
+        }
+    };
+#endif
+
     class Document
     {
     public:
-        explicit Document(std::string const & file_name, Layout layout_)
+        // On POSIX systems regular files are written through a MappedFile:
+        // each shape is appended to the mapping as it is added instead of
+        // being collected in memory. Shapes still serialize into a temporary
+        // string first, which is then copied into the mapping. Other targets,
+        // such as pipes or devices, and other platforms use an std::ofstream.
+        // As with a stream, a document destroyed without save() leaves an
+        // empty file.
+        explicit Document(std::string const & file_name_, Layout layout_)
             : layout(layout_)
-            , stream_real(file_name)
-            , stream(stream_real.value())
-            { }
+            , file_name(file_name_)
+            , stream(nullptr)
+        {
+#ifdef SIMPLE_SVG_MAPPED_FILE
+            MappedFile mapped(file_name);
+            if (mapped.good()) {
+                file.emplace(std::move(mapped));
+                std::string header;
+                appendHeader(header, layout);
+                file->append(header);
+                return;
+            }
+#endif
+            stream_real.emplace(file_name);
+            stream = &stream_real.value();
+        }
 
         explicit Document(std::ostream& out, Layout layout_)
             : layout(layout_)
-            , stream(out)
+            , stream(&out)
             { }
 
+        Document(Document && other)
+            : layout(other.layout)
+            , file_name(std::move(other.file_name))
+#ifdef SIMPLE_SVG_MAPPED_FILE
+            , file(std::move(other.file))
+#endif
+            , stream_real(std::move(other.stream_real))
+            , stream(stream_real ? &stream_real.value() : other.stream)
+            , body_nodes_str(std::move(other.body_nodes_str))
+            { }
+
+        ~Document()
+        {
+#ifdef SIMPLE_SVG_MAPPED_FILE
+            if (file)
+                file->discard();
+#endif
+        }
+
         Document & operator<<(Shape const & shape)
         {
+#ifdef SIMPLE_SVG_MAPPED_FILE
+            if (file) {
+                file->append(shape.toString(layout));
+                return *this;
+            }
+#endif
             body_nodes_str += shape.toString(layout);
             return *this;
         }
         std::string toString() const
         {
-            using namespace std::literals::string_literals;
-            std::stringstream ss;
-            ss << "<?xml "
-               << attribute("version", "1.0")
-               << attribute("standalone", "no")
-               << "?>\n<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" "
-               << "\"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">\n<svg "
-               << attribute("width", layout.window.width, "px")
-               << attribute("height", layout.window.height, "px")
-               << attribute("viewBox", "0 0 "s + std::to_string(layout.dimensions.width) +" "s + std::to_string(layout.dimensions.height) )
-               << attribute("preserveAspectRatio", "xMinYMin meet")
-               << attribute("xmlns", "http://www.w3.org/2000/svg")
-               << attribute("version", "1.1") << ">\n"
-               << body_nodes_str << elemEnd("svg");
-            return ss.str();
+#ifdef SIMPLE_SVG_MAPPED_FILE
+            // The body of a mapped document only exists in the file.
+            if (file) {
+                std::string out;
+                if (file->isOpen()) {
+                    out = file->contents();
+                } else {
+                    std::ifstream in(file_name, std::ios::binary);
+                    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                    std::string const end = footer();
+                    if (out.size() >= end.size() && out.compare(out.size() - end.size(), end.size(), end) == 0)
+                        out.resize(out.size() - end.size());
+                }
+                return out + footer();
+            }
+#endif
+            std::string out;
+            out.reserve(sizeof(svgProlog) + 256 + body_nodes_str.size());
+            appendHeader(out, layout);
+            out += body_nodes_str;
+            out += footer();
+            return out;
         }
         bool save()
         {
-            if (!stream.good())
+#ifdef SIMPLE_SVG_MAPPED_FILE
+            if (file) {
+                bool ok = file->append(footer());
+                return file->finish() && ok;
+            }
+#endif
+            if (!stream->good())
                 return false;
 
-            stream << toString();
+            std::string header;
+            appendHeader(header, layout);
+            *stream << header << body_nodes_str << footer();
             if (stream_real){
                 stream_real.value().close();
             }
@@ -652,11 +1065,122 @@ namespace svg
         }
     private:
         Layout layout;
+        std::string file_name;
+#ifdef SIMPLE_SVG_MAPPED_FILE
+        std::optional<MappedFile> file;
+#endif
         std::optional<std::ofstream> stream_real;
-        std::ostream& stream;
+        std::ostream* stream;
 
         std::string body_nodes_str;
+
+        static std::string footer()
+        {
+            return elemEnd("svg");
+        }
     };
+
+    // One document of a batch: the shapes are not owned and must outlive the
+    // call to renderBatch.
+    struct BatchJob
+    {
+        BatchJob(Layout const & layout_, std::string const & file_name_,
+            std::vector<Shape const *> const & shapes_ = {})
+            : layout(layout_), file_name(file_name_), shapes(shapes_) { }
+        BatchJob & operator<<(Shape const & shape)
+        {
+            shapes.push_back(&shape);
+            return *this;
+        }
+        Layout layout;
+        std::string file_name;
+        std::vector<Shape const *> shapes;
+    };
+
+#ifdef SIMPLE_SVG_POSIX_IO
+    // Replaces the contents of a file with bytes using plain system calls.
+    bool writeFile(std::string const & file_name, std::string const & bytes)
+    {
+        int fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        if (fd < 0)
+            return false;
+
+        char const * data = bytes.data();
+        std::size_t left = bytes.size();
+        while (left > 0) {
+            ssize_t count = ::write(fd, data, left);
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count <= 0)
+                break;
+            data += count;
+            left -= static_cast<std::size_t>(count);
+        }
+        return ::close(fd) == 0 && left == 0;
+    }
+#endif
+
+    // Renders many small documents on a pool of worker threads. Idle workers
+    // pull the next unclaimed job, so uneven jobs still balance across cores.
+    // Every worker serializes into one string buffer that it reuses for all
+    // of its jobs and writes it without constructing a stream per file. A job that throws counts as failed; if threads cannot be
+    // started the remaining jobs run on the threads that could.
+    // Returns the number of documents that were written successfully.
+    std::size_t renderBatch(std::vector<BatchJob> const & jobs,
+        unsigned threads = std::thread::hardware_concurrency())
+    {
+        std::atomic<std::size_t> next_job(0);
+        std::atomic<std::size_t> written(0);
+
+        auto worker = [&]() {
+            std::string buffer;
+#ifndef SIMPLE_SVG_POSIX_IO
+            std::filebuf file;
+#endif
+            for (std::size_t i = next_job++; i < jobs.size(); i = next_job++) {
+                try {
+                    BatchJob const & job = jobs[i];
+
+                    buffer.clear();
+                    appendHeader(buffer, job.layout);
+                    for (Shape const * shape : job.shapes)
+                        buffer += shape->toString(job.layout);
+                    buffer += elemEnd("svg");
+
+#ifdef SIMPLE_SVG_POSIX_IO
+                    if (writeFile(job.file_name, buffer))
+                        ++written;
+#else
+                    if (file.open(job.file_name, std::ios::out | std::ios::binary | std::ios::trunc)) {
+                        bool ok = file.sputn(buffer.data(), static_cast<std::streamsize>(buffer.size()))
+                            == static_cast<std::streamsize>(buffer.size());
+                        if (file.close() && ok)
+                            ++written;
+                    }
+#endif
+                } catch (...) {
+                }
+            }
+        };
+
+        if (threads == 0)
+            threads = 1;
+        if (threads > jobs.size())
+            threads = static_cast<unsigned>(jobs.size());
+
+        std::vector<std::thread> pool;
+        try {
+            pool.reserve(threads);
+            for (unsigned t = 1; t < threads; ++t)
+                pool.emplace_back(worker);
+        } catch (...) {
+        }
+        worker();
+        for (std::thread & thread : pool)
+            thread.join();
+
+        return written;
+    }
 }
 
 #endif